@@ -0,0 +1,5 @@
+@echo off
+rem Builds the scanner benchmark harness. Run from a Visual Studio developer
+rem prompt (needs cl.exe on PATH) with the same flags build.rs passes to the
+rem cc crate, plus /O2 so timings reflect release codegen.
+cl /nologo /std:c++20 /EHsc /O2 /W4 bench_main.cpp /Fe:omni_bench.exe
@@ -53,6 +53,21 @@ struct SearchResult {
     created_unix: i64,
     modified_unix: i64,
     is_directory: bool,
+    /// True when attributes were deferred off the search thread; the UI
+    /// hydrates such rows through the `file_metadata` command.
+    metadata_pending: bool,
+    /// File reference number as a string — 64-bit FRNs do not survive a
+    /// JavaScript number.
+    frn: String,
+}
+
+#[derive(Debug, Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+struct SearchPage {
+    done: bool,
+    cancelled: bool,
+    total: u64,
+    rows: Vec<SearchResult>,
 }
 
 const SEND_TO_PHONE_ARG: &str = "--send-to-phone";
@@ -202,6 +217,39 @@ unsafe extern "C" {
         limit: u32,
     ) -> *mut c_char;
     fn omni_cancel_search() -> bool;
+    fn omni_search_files_binary(
+        query_utf8: *const c_char,
+        extension_utf8: *const c_char,
+        min_size: u64,
+        max_size: u64,
+        min_created_unix: i64,
+        max_created_unix: i64,
+        limit: u32,
+        out_byte_count: *mut u32,
+    ) -> *mut u8;
+    fn omni_compile_query(query_utf8: *const c_char, extension_utf8: *const c_char) -> u64;
+    fn omni_query_close(query_handle: u64) -> bool;
+    fn omni_search_files_binary_compiled(
+        query_handle: u64,
+        min_size: u64,
+        max_size: u64,
+        min_created_unix: i64,
+        max_created_unix: i64,
+        limit: u32,
+        out_byte_count: *mut u32,
+    ) -> *mut u8;
+    fn omni_free_buffer(ptr: *mut u8);
+    fn omni_search_begin(
+        query_utf8: *const c_char,
+        extension_utf8: *const c_char,
+        min_size: u64,
+        max_size: u64,
+        min_created_unix: i64,
+        max_created_unix: i64,
+        limit: u32,
+    ) -> u64;
+    fn omni_search_fetch_json(session_id: u64, offset: u32, count: u32) -> *mut c_char;
+    fn omni_search_close(session_id: u64) -> bool;
     fn omni_find_duplicates_json(
         min_size: u64,
         max_groups: u32,
@@ -209,6 +257,10 @@ unsafe extern "C" {
     ) -> *mut c_char;
     fn omni_cancel_duplicate_scan() -> bool;
     fn omni_duplicate_scan_status_json() -> *mut c_char;
+    fn omni_perf_stats_json() -> *mut c_char;
+    fn omni_content_index_configure(roots_utf8: *const c_char, enabled: bool) -> bool;
+    fn omni_content_index_status_json() -> *mut c_char;
+    fn omni_file_metadata_json(path_utf8: *const c_char, frn: u64) -> *mut c_char;
     fn omni_list_drives_json() -> *mut c_char;
     fn omni_delete_path(path_utf8: *const c_char, recycle_bin: bool) -> bool;
     fn omni_free_string(ptr: *mut c_char);
@@ -230,6 +282,70 @@ fn read_last_error() -> Option<String> {
     }
 }
 
+/// Decodes the flat binary layout written by `omni_search_files_binary`: a
+/// 16-byte header (magic, version, row count, text pool byte offset), then
+/// fixed 64-byte row records whose string fields are offset/length pairs in
+/// UTF-16 code units into the text pool. Every access is bounds-checked so a
+/// malformed buffer fails with an error instead of reading out of range.
+#[cfg(target_os = "windows")]
+fn parse_binary_search_results(bytes: &[u8]) -> Result<Vec<SearchResult>, String> {
+    const MAGIC: u32 = 0x424E_4D4F; // "OMNB"
+    const VERSION: u32 = 2;
+    const HEADER_BYTES: usize = 16;
+    const ROW_BYTES: usize = 64;
+    const FLAG_DIRECTORY: u32 = 0x1;
+    const FLAG_METADATA_PENDING: u32 = 0x2;
+
+    fn truncated() -> String {
+        "Truncated search result buffer".to_string()
+    }
+    let read_u32 = |offset: usize| -> Result<u32, String> {
+        let slice = bytes.get(offset..offset + 4).ok_or_else(truncated)?;
+        Ok(u32::from_le_bytes(slice.try_into().unwrap()))
+    };
+    let read_u64 = |offset: usize| -> Result<u64, String> {
+        let slice = bytes.get(offset..offset + 8).ok_or_else(truncated)?;
+        Ok(u64::from_le_bytes(slice.try_into().unwrap()))
+    };
+
+    if read_u32(0)? != MAGIC || read_u32(4)? != VERSION {
+        return Err("Unrecognized search result buffer format".to_string());
+    }
+    let row_count = read_u32(8)? as usize;
+    let text_offset = read_u32(12)? as usize;
+    if text_offset < HEADER_BYTES + row_count * ROW_BYTES || text_offset > bytes.len() {
+        return Err(truncated());
+    }
+    let text_pool = &bytes[text_offset..];
+    let read_text = |offset_units: u32, length_units: u32| -> Result<String, String> {
+        let begin = offset_units as usize * 2;
+        let end = begin + length_units as usize * 2;
+        let slice = text_pool.get(begin..end).ok_or_else(truncated)?;
+        let units: Vec<u16> = slice
+            .chunks_exact(2)
+            .map(|pair| u16::from_le_bytes([pair[0], pair[1]]))
+            .collect();
+        Ok(String::from_utf16_lossy(&units))
+    };
+
+    let mut results = Vec::with_capacity(row_count);
+    for row in 0..row_count {
+        let base = HEADER_BYTES + row * ROW_BYTES;
+        results.push(SearchResult {
+            name: read_text(read_u32(base + 24)?, read_u32(base + 28)?)?,
+            path: read_text(read_u32(base + 32)?, read_u32(base + 36)?)?,
+            extension: read_text(read_u32(base + 40)?, read_u32(base + 44)?)?,
+            size: read_u64(base)?,
+            created_unix: read_u64(base + 8)? as i64,
+            modified_unix: read_u64(base + 16)? as i64,
+            is_directory: read_u32(base + 48)? & FLAG_DIRECTORY != 0,
+            metadata_pending: read_u32(base + 48)? & FLAG_METADATA_PENDING != 0,
+            frn: read_u64(base + 56)?.to_string(),
+        });
+    }
+    Ok(results)
+}
+
 #[cfg(target_os = "windows")]
 fn current_status() -> IndexStatus {
     // SAFETY: FFI functions have no side effects beyond reading atomics.
@@ -297,6 +413,45 @@ fn index_status() -> IndexStatus {
     current_status()
 }
 
+/// The most recently compiled (query, extension) pair and its scanner-side
+/// handle, plus the previous handle kept alive for one generation. Typeahead
+/// re-issues identical searches whenever filters are toggled or the index
+/// generation bumps, so reusing the handle skips the scanner's query parsing
+/// on those calls. The grace slot keeps a replaced handle valid for any
+/// search that fetched it just before a concurrent call swapped the cache.
+#[cfg(target_os = "windows")]
+#[allow(clippy::type_complexity)]
+static COMPILED_QUERY_CACHE: std::sync::Mutex<(Option<(String, String, u64)>, Option<u64>)> =
+    std::sync::Mutex::new((None, None));
+
+/// Returns a compiled-query handle for `(query, extension)`, reusing the
+/// cached handle when the inputs match the previous call.
+#[cfg(target_os = "windows")]
+fn compiled_query_handle(query: &str, extension: &str) -> Result<u64, String> {
+    let mut cache = COMPILED_QUERY_CACHE
+        .lock()
+        .map_err(|_| "Query cache poisoned".to_string())?;
+    if let Some((cached_query, cached_extension, handle)) = cache.0.as_ref() {
+        if cached_query == query && cached_extension == extension {
+            return Ok(*handle);
+        }
+    }
+    let c_query = CString::new(query).map_err(|_| "Invalid query".to_string())?;
+    let c_extension = CString::new(extension).map_err(|_| "Invalid extension".to_string())?;
+    // SAFETY: Inputs are valid null-terminated strings.
+    let handle = unsafe { omni_compile_query(c_query.as_ptr(), c_extension.as_ptr()) };
+    if handle == 0 {
+        return Err(read_last_error().unwrap_or_else(|| "Failed to compile query".to_string()));
+    }
+    if let Some(retired_handle) = cache.1.take() {
+        // SAFETY: FFI call only releases a handle this cache owns.
+        unsafe { omni_query_close(retired_handle) };
+    }
+    cache.1 = cache.0.take().map(|(_, _, old_handle)| old_handle);
+    cache.0 = Some((query.to_string(), extension.to_string(), handle));
+    Ok(handle)
+}
+
 #[tauri::command]
 async fn search_files(
     query: String,
@@ -310,9 +465,8 @@ async fn search_files(
     #[cfg(target_os = "windows")]
     {
         tauri::async_runtime::spawn_blocking(move || -> Result<Vec<SearchResult>, String> {
-            let c_query = CString::new(query).map_err(|_| "Invalid query".to_string())?;
-            let c_extension = CString::new(extension.unwrap_or_default())
-                .map_err(|_| "Invalid extension".to_string())?;
+            let extension = extension.unwrap_or_default();
+            let query_handle = compiled_query_handle(&query, &extension)?;
 
             let min_size = min_size.unwrap_or(0);
             let max_size = max_size.unwrap_or(u64::MAX);
@@ -320,30 +474,31 @@ async fn search_files(
             let max_created_unix = max_created_unix.unwrap_or(i64::MAX);
             let limit = limit.unwrap_or(200).clamp(1, 5_000);
 
-            // SAFETY: Inputs are valid null-terminated strings and primitive values.
-            let raw_json = unsafe {
-                omni_search_files_json(
-                    c_query.as_ptr(),
-                    c_extension.as_ptr(),
+            let mut byte_count: u32 = 0;
+            // SAFETY: The handle was issued by omni_compile_query and stays
+            // alive for the duration of the call (the scanner holds its own
+            // reference even if the cache replaces it concurrently).
+            let raw = unsafe {
+                omni_search_files_binary_compiled(
+                    query_handle,
                     min_size,
                     max_size,
                     min_created_unix,
                     max_created_unix,
                     limit,
+                    &mut byte_count,
                 )
             };
-            if raw_json.is_null() {
+            if raw.is_null() {
                 return Err(read_last_error().unwrap_or_else(|| "Search failed".to_string()));
             }
 
-            // SAFETY: `raw_json` points to a C string allocated by C++.
-            let json = unsafe { CStr::from_ptr(raw_json).to_string_lossy().to_string() };
-            // SAFETY: `raw_json` was allocated by C++ and must be released by C++.
-            unsafe { omni_free_string(raw_json) };
-
-            let parsed: Vec<SearchResult> = serde_json::from_str(&json)
-                .map_err(|err| format!("Invalid search payload: {err}"))?;
-            Ok(parsed)
+            // SAFETY: The C++ side wrote exactly `byte_count` bytes at `raw`.
+            let bytes = unsafe { std::slice::from_raw_parts(raw, byte_count as usize) };
+            let parsed = parse_binary_search_results(bytes);
+            // SAFETY: `raw` was allocated by C++ and must be released by C++.
+            unsafe { omni_free_buffer(raw) };
+            parsed
         })
         .await
         .map_err(|err| format!("Search task failed: {err}"))?
@@ -379,6 +534,116 @@ fn cancel_search() -> Result<bool, String> {
     }
 }
 
+#[tauri::command]
+fn search_begin(
+    query: String,
+    extension: Option<String>,
+    min_size: Option<u64>,
+    max_size: Option<u64>,
+    min_created_unix: Option<i64>,
+    max_created_unix: Option<i64>,
+    limit: Option<u32>,
+) -> Result<u64, String> {
+    #[cfg(target_os = "windows")]
+    {
+        let c_query = CString::new(query).map_err(|_| "Invalid query".to_string())?;
+        let c_extension = CString::new(extension.unwrap_or_default())
+            .map_err(|_| "Invalid extension".to_string())?;
+
+        let min_size = min_size.unwrap_or(0);
+        let max_size = max_size.unwrap_or(u64::MAX);
+        let min_created_unix = min_created_unix.unwrap_or(i64::MIN);
+        let max_created_unix = max_created_unix.unwrap_or(i64::MAX);
+        let limit = limit.unwrap_or(200).clamp(1, 5_000);
+
+        // SAFETY: Inputs are valid null-terminated strings and primitive values.
+        // The C++ side copies them before returning, then scans on its own thread.
+        let session_id = unsafe {
+            omni_search_begin(
+                c_query.as_ptr(),
+                c_extension.as_ptr(),
+                min_size,
+                max_size,
+                min_created_unix,
+                max_created_unix,
+                limit,
+            )
+        };
+        if session_id == 0 {
+            return Err(read_last_error().unwrap_or_else(|| "Failed to start search".to_string()));
+        }
+        return Ok(session_id);
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    {
+        let _ = (
+            query,
+            extension,
+            min_size,
+            max_size,
+            min_created_unix,
+            max_created_unix,
+            limit,
+        );
+        Err("OmniSearch scanner is only supported on Windows.".to_string())
+    }
+}
+
+#[tauri::command]
+async fn search_fetch(
+    session_id: u64,
+    offset: Option<u32>,
+    count: Option<u32>,
+) -> Result<SearchPage, String> {
+    #[cfg(target_os = "windows")]
+    {
+        tauri::async_runtime::spawn_blocking(move || -> Result<SearchPage, String> {
+            let offset = offset.unwrap_or(0);
+            let count = count.unwrap_or(200).clamp(1, 5_000);
+
+            // SAFETY: Inputs are plain integers and function returns an allocated C string or null.
+            let raw_json = unsafe { omni_search_fetch_json(session_id, offset, count) };
+            if raw_json.is_null() {
+                return Err(read_last_error().unwrap_or_else(|| "Search fetch failed".to_string()));
+            }
+
+            // SAFETY: `raw_json` points to a C string allocated by C++.
+            let json = unsafe { CStr::from_ptr(raw_json).to_string_lossy().to_string() };
+            // SAFETY: `raw_json` was allocated by C++ and must be released by C++.
+            unsafe { omni_free_string(raw_json) };
+
+            let parsed: SearchPage = serde_json::from_str(&json)
+                .map_err(|err| format!("Invalid search page payload: {err}"))?;
+            Ok(parsed)
+        })
+        .await
+        .map_err(|err| format!("Search fetch task failed: {err}"))?
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    {
+        let _ = (session_id, offset, count);
+        Err("OmniSearch scanner is only supported on Windows.".to_string())
+    }
+}
+
+#[tauri::command]
+fn search_close(session_id: u64) -> Result<bool, String> {
+    #[cfg(target_os = "windows")]
+    {
+        // SAFETY: FFI call only tears down session bookkeeping.
+        let closed = unsafe { omni_search_close(session_id) };
+        Ok(closed)
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    {
+        let _ = session_id;
+        Err("OmniSearch scanner is only supported on Windows.".to_string())
+    }
+}
+
 #[tauri::command]
 async fn find_duplicate_groups(
     min_size: Option<u64>,
@@ -446,6 +711,111 @@ fn duplicate_scan_status() -> Result<DuplicateScanStatus, String> {
     }
 }
 
+#[tauri::command]
+fn perf_stats() -> Result<serde_json::Value, String> {
+    #[cfg(target_os = "windows")]
+    {
+        // SAFETY: No inputs, returns an allocated C string or null.
+        let raw_json = unsafe { omni_perf_stats_json() };
+        if raw_json.is_null() {
+            return Err(read_last_error()
+                .unwrap_or_else(|| "Failed to read performance stats.".to_string()));
+        }
+
+        // SAFETY: `raw_json` points to a C string allocated by C++.
+        let json = unsafe { CStr::from_ptr(raw_json).to_string_lossy().to_string() };
+        // SAFETY: `raw_json` was allocated by C++ and must be released by C++.
+        unsafe { omni_free_string(raw_json) };
+
+        // Passed through as-is: the counter set is diagnostic and evolves
+        // with the scanner, so no typed struct on this side.
+        let parsed: serde_json::Value = serde_json::from_str(&json)
+            .map_err(|err| format!("Invalid perf stats payload: {err}"))?;
+        Ok(parsed)
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    {
+        Err("OmniSearch scanner is only supported on Windows.".to_string())
+    }
+}
+
+#[tauri::command]
+fn content_index_configure(roots: String, enabled: bool) -> Result<bool, String> {
+    #[cfg(target_os = "windows")]
+    {
+        let c_roots = CString::new(roots).map_err(|_| "Invalid roots".to_string())?;
+        // SAFETY: Input is a valid null-terminated string.
+        let ok = unsafe { omni_content_index_configure(c_roots.as_ptr(), enabled) };
+        Ok(ok)
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    {
+        let _ = (roots, enabled);
+        Err("OmniSearch scanner is only supported on Windows.".to_string())
+    }
+}
+
+#[tauri::command]
+fn content_index_status() -> Result<serde_json::Value, String> {
+    #[cfg(target_os = "windows")]
+    {
+        // SAFETY: No inputs, returns an allocated C string or null.
+        let raw_json = unsafe { omni_content_index_status_json() };
+        if raw_json.is_null() {
+            return Err(read_last_error()
+                .unwrap_or_else(|| "Failed to read content index status.".to_string()));
+        }
+
+        // SAFETY: `raw_json` points to a C string allocated by C++.
+        let json = unsafe { CStr::from_ptr(raw_json).to_string_lossy().to_string() };
+        // SAFETY: `raw_json` was allocated by C++ and must be released by C++.
+        unsafe { omni_free_string(raw_json) };
+
+        let parsed: serde_json::Value = serde_json::from_str(&json)
+            .map_err(|err| format!("Invalid content index status payload: {err}"))?;
+        Ok(parsed)
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    {
+        Err("OmniSearch scanner is only supported on Windows.".to_string())
+    }
+}
+
+#[tauri::command]
+fn file_metadata(path: String, frn: String) -> Result<serde_json::Value, String> {
+    #[cfg(target_os = "windows")]
+    {
+        // The FRN crosses from the frontend as a string because 64-bit values
+        // do not survive a JavaScript number.
+        let frn: u64 = frn.parse().map_err(|_| "Invalid file reference number".to_string())?;
+        let c_path = CString::new(path).map_err(|_| "Invalid path".to_string())?;
+        // SAFETY: Input is a valid null-terminated string.
+        let raw_json = unsafe { omni_file_metadata_json(c_path.as_ptr(), frn) };
+        if raw_json.is_null() {
+            return Err(read_last_error()
+                .unwrap_or_else(|| "Failed to read file metadata.".to_string()));
+        }
+
+        // SAFETY: `raw_json` points to a C string allocated by C++.
+        let json = unsafe { CStr::from_ptr(raw_json).to_string_lossy().to_string() };
+        // SAFETY: `raw_json` was allocated by C++ and must be released by C++.
+        unsafe { omni_free_string(raw_json) };
+
+        let parsed: serde_json::Value = serde_json::from_str(&json)
+            .map_err(|err| format!("Invalid file metadata payload: {err}"))?;
+        Ok(parsed)
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    {
+        let _ = (path, frn);
+        Err("OmniSearch scanner is only supported on Windows.".to_string())
+    }
+}
+
 #[tauri::command]
 fn cancel_duplicate_scan() -> Result<bool, String> {
     #[cfg(target_os = "windows")]
@@ -1388,9 +1758,16 @@ pub fn run() {
             index_status,
             search_files,
             cancel_search,
+            search_begin,
+            search_fetch,
+            search_close,
             find_duplicate_groups,
             duplicate_scan_status,
             cancel_duplicate_scan,
+            perf_stats,
+            content_index_configure,
+            content_index_status,
+            file_metadata,
             delete_path,
             rename_path,
             list_drives,